@@ -20,6 +20,7 @@
 #ifndef HD44780_H_
 #define HD44780_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <avr/io.h>
 
@@ -48,6 +49,11 @@ enum {
 
 #define DIMENSION_TYPE_MAX DIMENSION_40_2
 
+/**
+ * Largest cell count (column * row) across all dimension types
+ */
+#define DIMENSION_CELL_MAX 80
+
 /**
  * Font table type
  */
@@ -66,6 +72,17 @@ enum {
 	INTERFACE_8_BIT,			// all comamnds sent in 8-bit segments
 };
 
+/**
+ * Controller profile type
+ */
+enum {
+	PROFILE_HD44780 = 0,			// Hitachi HD44780 (worst-case timing)
+	PROFILE_KS0066,				// Samsung KS0066/Sitronix ST7066
+	PROFILE_WS0010,				// Winstar WS0010 OLED (NHD-0216KZW)
+};
+
+#define PROFILE_TYPE_MAX PROFILE_WS0010
+
 /**
  * Direction register name macro
  * Allows the caller to specify a direction register by name
@@ -73,6 +90,13 @@ enum {
  */
 #define DEFINE_DDR(_BNK_) DDR ## _BNK_
 
+/**
+ * Input register name macro
+ * Allows the caller to specify an input register by name
+ * @param _BNK_ register alphabetic name
+ */
+#define DEFINE_INPUT(_BNK_) PIN ## _BNK_
+
 /**
  * Pin name macro
  * Allows the caller to specify a pin on a specified register by name
@@ -94,6 +118,7 @@ enum {
 typedef struct _hdcont_comm_t {
 	volatile uint8_t *ddr_control;		// control port direction
 	volatile uint8_t *ddr_data;		// data port direction
+	volatile uint8_t *pin_data;		// data port input
 	uint8_t pin_control_direction;		// direction pin
 	uint8_t pin_control_enable;		// enable pin
 	uint8_t pin_control_select;		// select pin
@@ -101,6 +126,20 @@ typedef struct _hdcont_comm_t {
 	volatile uint8_t *port_data;		// data port
 } hdcont_comm_t;
 
+/**
+ * Holds controller timing information
+ * The command delay only precedes the first busy flag poll; completion is 
+ *   always taken from the busy flag. Profiles with short delays (WS0010: 600 us 
+ *   per instruction, 2 ms clear) therefore require the direction (R/W) pin to 
+ *   be wired to the controller
+ */
+typedef struct _hdcont_timing_t {
+	uint8_t command;			// delay before busy flag poll (us)
+	uint8_t initialize;			// power-on delay (ms)
+	uint8_t latch;				// enable pulse width (us)
+	uint16_t timeout;			// busy flag timeout (us)
+} hdcont_timing_t;
+
 /**
  * Holds cursor/display state information
  */
@@ -114,16 +153,159 @@ typedef struct _hdcont_state_t {
 	uint8_t display_show;			// show display flag
 } hdcont_state_t;
 
+/**
+ * Data line type
+ */
+enum {
+	MAP_LINE_D0 = 0,			// data line 0 (8-bit only)
+	MAP_LINE_D1,				// data line 1 (8-bit only)
+	MAP_LINE_D2,				// data line 2 (8-bit only)
+	MAP_LINE_D3,				// data line 3 (8-bit only)
+	MAP_LINE_D4,				// data line 4
+	MAP_LINE_D5,				// data line 5
+	MAP_LINE_D6,				// data line 6
+	MAP_LINE_D7,				// data line 7 (busy flag)
+};
+
+#define MAP_LINE_MAX (MAP_LINE_D7 + 1)
+#define MAP_LINE_NONE 0xff
+#define MAP_PORT_MAX 2
+#define MAP_TABLE_LEN 16
+
+/**
+ * Holds data line mapping information
+ */
+typedef struct _hdmap_t {
+	volatile uint8_t *ddr[MAP_PORT_MAX];	// data port direction
+	volatile uint8_t *pin[MAP_PORT_MAX];	// data port input
+	volatile uint8_t *port[MAP_PORT_MAX];	// data port
+	uint8_t line[MAP_LINE_MAX];		// data line port/pin
+	uint8_t mask[MAP_PORT_MAX];		// data line mask (per port)
+	uint8_t table_high[MAP_PORT_MAX][MAP_TABLE_LEN];	// D4-D7 nibble masks (per port)
+	uint8_t table_low[MAP_PORT_MAX][MAP_TABLE_LEN];	// D0-D3 nibble masks (per port)
+} hdmap_t;
+
+/**
+ * Holds refresh scheduler information
+ */
+typedef struct _hdsched_t {
+	uint8_t cell[DIMENSION_CELL_MAX];	// pending cell contents
+	uint8_t cell_commit[DIMENSION_CELL_MAX];	// committed cell contents
+	uint8_t control;			// committed cursor/display flags
+	uint8_t dirty;				// pending update flags
+	uint16_t elapsed;			// time since last commit (ms)
+	uint16_t period;			// time between commits (ms)
+} hdsched_t;
+
+/**
+ * Holds console line buffer information
+ */
+typedef struct _hdcons_t {
+	uint8_t cell[DIMENSION_CELL_MAX];	// line buffer contents
+} hdcons_t;
+
+/**
+ * Glyph (CGRAM) limits
+ */
+#define GLYPH_MAX 8
+#define GLYPH_ROW_LEN 8
+
+/**
+ * Calibration record count (EEPROM)
+ * Each record holds the calibrated timing of one panel
+ */
+#ifndef CALIBRATION_SLOT_MAX
+#define CALIBRATION_SLOT_MAX 4
+#endif // CALIBRATION_SLOT_MAX
+
+/**
+ * Compositor limits
+ */
+#define LAYER_MAX 4
+
+/**
+ * Multi-device limits
+ */
+#define MULTI_CONTEXT_MAX 4
+#define MULTI_QUEUE_LEN 16
+
+/**
+ * Holds multi-device transaction queue information
+ */
+typedef struct _hdmulti_queue_t {
+	uint8_t count;				// queued transaction count
+	uint8_t data[MULTI_QUEUE_LEN];		// queued transaction data
+	uint16_t elapsed;			// time spent busy (us)
+	uint8_t head;				// next queued transaction
+	uint8_t pending;			// transaction in progress flag
+	uint8_t select[(MULTI_QUEUE_LEN + 7) / 8];	// queued transaction select flags (bitmask)
+} hdmulti_queue_t;
+
 /**
  * Holds device context information
  */
 typedef struct _hdcont_t {
 	uint8_t dimension;			// dimension type
 	uint8_t interface;			// interface type
+	uint8_t profile;			// controller profile type
+	hdcont_timing_t timing;			// controller timing
 	hdcont_comm_t comm;			// pin/port connections
 	hdcont_state_t state;			// cursor/display state
+	hdmap_t *map;				// data line mapping (optional)
+	hdsched_t *schedule;			// refresh scheduler (optional)
+	hdcons_t *console;			// console line buffer (optional)
 } hdcont_t;
 
+/**
+ * Holds glyph animation information
+ */
+typedef struct _hdanim_slot_t {
+	uint16_t elapsed;			// time since last frame (ms)
+	const uint8_t *frame;			// frame bitmaps (GLYPH_ROW_LEN bytes each)
+	uint8_t frame_count;			// frame count
+	uint8_t frame_current;			// current frame
+	uint16_t period;			// time between frames (ms)
+} hdanim_slot_t;
+
+/**
+ * Holds glyph animation engine information
+ */
+typedef struct _hdanim_t {
+	uint8_t budget;				// maximum glyph updates per tick
+	hdcont_t *context;			// animated device context
+	uint8_t next;				// next slot to update (round-robin)
+	hdanim_slot_t slot[GLYPH_MAX];		// per-glyph animations
+} hdanim_t;
+
+/**
+ * Holds compositor overlay layer information
+ */
+typedef struct _hdlayer_t {
+	uint8_t *cell;				// layer contents (width * height)
+	uint8_t column;				// layer column
+	uint8_t height;				// layer row count
+	uint8_t row;				// layer row
+	uint8_t visible;			// layer visible flag
+	uint8_t width;				// layer column count
+} hdlayer_t;
+
+/**
+ * Holds compositor information
+ */
+typedef struct _hdcomp_t {
+	uint8_t cell[DIMENSION_CELL_MAX];	// base layer contents
+	hdcont_t *context;			// composited device context
+	hdlayer_t *layer[LAYER_MAX];		// overlay layers (bottom to top)
+} hdcomp_t;
+
+/**
+ * Holds multi-device driver information
+ */
+typedef struct _hdmulti_t {
+	hdcont_t *context[MULTI_CONTEXT_MAX];	// attached device contexts
+	hdmulti_queue_t queue[MULTI_CONTEXT_MAX];	// per-device transaction queues
+} hdmulti_t;
+
 /***********************************************************************************
  * ** Setup routines **
  * These routines must be called during initialize and uninitialize
@@ -144,15 +326,58 @@ typedef struct _hdcont_t {
  */
 #define hd44780_initialize(_CONT_, _DIM_, _INTER_, _FONT_, _DATA_, _CTRL_, _SEL_, \
 		_DIR_, _E_) \
-	_hd44780_initialize(_CONT_, _DIM_, _INTER_, _FONT_, &DEFINE_DDR(_DATA_), \
-	&DEFINE_PORT(_DATA_), &DEFINE_DDR(_CTRL_), &DEFINE_PORT(_CTRL_), \
-	DEFINE_PIN(_CTRL_, _SEL_), DEFINE_PIN(_CTRL_, _DIR_), DEFINE_PIN(_CTRL_, _E_))
+	hd44780_initialize_profile(_CONT_, _DIM_, _INTER_, _FONT_, PROFILE_HD44780, \
+	_DATA_, _CTRL_, _SEL_, _DIR_, _E_)
+
+/**
+ * Device initialization macro (controller profile)
+ * This macro must be called prior to any other device calls
+ * @param _CONT_ caller supplied device context pointer
+ * @param _DIM_ device dimension type
+ * @param _INTER_ device interface type
+ * @param _FONT_ device font table type
+ * @param _PROF_ device controller profile type
+ * @param _DATA_ device data port
+ * @param _CTRL_ device control port
+ * @param _SEL_ device select pin
+ * @param _DIR_ device direction pin
+ * @param _E_ device enable pin
+ */
+#define hd44780_initialize_profile(_CONT_, _DIM_, _INTER_, _FONT_, _PROF_, _DATA_, \
+		_CTRL_, _SEL_, _DIR_, _E_) \
+	_hd44780_initialize(_CONT_, NULL, _DIM_, _INTER_, _FONT_, _PROF_, &DEFINE_DDR(_DATA_), \
+	&DEFINE_INPUT(_DATA_), &DEFINE_PORT(_DATA_), &DEFINE_DDR(_CTRL_), \
+	&DEFINE_PORT(_CTRL_), DEFINE_PIN(_CTRL_, _SEL_), DEFINE_PIN(_CTRL_, _DIR_), \
+	DEFINE_PIN(_CTRL_, _E_))
+
+/**
+ * Device initialization macro (mapped data lines)
+ * This macro must be called prior to any other device calls
+ * @param _CONT_ caller supplied device context pointer
+ * @param _MAP_ caller supplied data line map pointer
+ * @param _DIM_ device dimension type
+ * @param _INTER_ device interface type
+ * @param _FONT_ device font table type
+ * @param _PROF_ device controller profile type
+ * @param _CTRL_ device control port
+ * @param _SEL_ device select pin
+ * @param _DIR_ device direction pin
+ * @param _E_ device enable pin
+ */
+#define hd44780_initialize_mapped(_CONT_, _MAP_, _DIM_, _INTER_, _FONT_, _PROF_, \
+		_CTRL_, _SEL_, _DIR_, _E_) \
+	_hd44780_initialize(_CONT_, _MAP_, _DIM_, _INTER_, _FONT_, _PROF_, NULL, NULL, \
+	NULL, &DEFINE_DDR(_CTRL_), &DEFINE_PORT(_CTRL_), DEFINE_PIN(_CTRL_, _SEL_), \
+	DEFINE_PIN(_CTRL_, _DIR_), DEFINE_PIN(_CTRL_, _E_))
 void _hd44780_initialize(
 	__out hdcont_t *context,
+	__in hdmap_t *map,
 	__in uint8_t dimension,
 	__in uint8_t interface,
 	__in uint8_t font,
+	__in uint8_t profile,
 	__in volatile uint8_t *ddr_data,
+	__in volatile uint8_t *pin_data,
 	__in volatile uint8_t *port_data,
 	__in volatile uint8_t *ddr_control,
 	__in volatile uint8_t *port_control,
@@ -161,6 +386,38 @@ void _hd44780_initialize(
 	__in uint8_t pin_control_enable
 	);
 
+/**
+ * Data line map clear routine
+ * Allows the caller to reset a data line map prior to mapping its lines
+ * @param map caller supplied data line map pointer
+ */
+void hd44780_map_clear(
+	__out hdmap_t *map
+	);
+
+/**
+ * Data line map macro
+ * Allows the caller to map a data line onto an arbitrary port pin. Data lines 
+ *   may be spread across at most two ports (MAP_PORT_MAX). In 4-bit mode, only 
+ *   lines D4-D7 need to be mapped
+ * NOTE: The map must remain valid for as long as the device context is in use
+ * @param _MAP_ caller supplied data line map pointer
+ * @param _LINE_ data line type
+ * @param _BNK_ data line port
+ * @param _PIN_ data line pin
+ */
+#define hd44780_map_line(_MAP_, _LINE_, _BNK_, _PIN_) \
+	_hd44780_map_line(_MAP_, _LINE_, &DEFINE_DDR(_BNK_), &DEFINE_INPUT(_BNK_), \
+	&DEFINE_PORT(_BNK_), DEFINE_PIN(_BNK_, _PIN_))
+void _hd44780_map_line(
+	__in hdmap_t *map,
+	__in uint8_t line,
+	__in volatile uint8_t *ddr,
+	__in volatile uint8_t *pin,
+	__in volatile uint8_t *port,
+	__in uint8_t pin_data
+	);
+
 /**
  * Device uninitialization routine
  * This routine must be called after all other device calls
@@ -255,6 +512,21 @@ void hd44780_display_clear(
 	__in hdcont_t *context
 	);
 
+/**
+ * Display glyph routine
+ * Allows the caller to define a custom glyph (CGRAM character) of a specified 
+ *   device context. The glyph is displayed by printing its slot number as a 
+ *   character
+ * @param context caller supplied device context pointer
+ * @param slot glyph slot (0 - GLYPH_MAX - 1)
+ * @param bitmap caller supplied glyph bitmap (GLYPH_ROW_LEN rows, 5 bits each)
+ */
+void hd44780_display_glyph(
+	__in hdcont_t *context,
+	__in uint8_t slot,
+	__in const uint8_t *bitmap
+	);
+
 /**
  * Display character routine
  * Allows the caller to place a character onto the display of a specified 
@@ -279,6 +551,480 @@ void hd44780_display_puts(
 	__in char *input
 	);
 
+/**
+ * OLED mode flags
+ */
+#define OLED_MODE_CHARACTER 0
+#define OLED_MODE_GRAPHIC 1
+
+/**
+ * OLED power flags
+ */
+#define OLED_POWER_OFF 0
+#define OLED_POWER_ON 1
+
+/**
+ * OLED mode/power routine
+ * Allows the caller to configure the mode and internal power of a specified 
+ *   device context. This routine has no effect unless the device context was 
+ *   initialized with the WS0010 controller profile
+ * @param context caller supplied device context pointer
+ * @param mode OLED mode flag (0: CHARACTER, 1: GRAPHIC)
+ * @param power OLED power flag (0: OFF, 1: ON)
+ */
+void hd44780_oled(
+	__in hdcont_t *context,
+	__in uint8_t mode,
+	__in uint8_t power
+	);
+
+/***********************************************************************************
+ * ** Schedule routines **
+ * These routines limit the rate at which a devices display is refreshed. While a 
+ *   scheduler is attached, cursor/display routines only update pending state, 
+ *   which is committed to the device (at most once per frame) by the tick routine
+ ***********************************************************************************/
+
+/**
+ * Schedule attach routine
+ * Allows the caller to attach a refresh scheduler to a specified device context
+ * NOTE: The display is cleared and the cursor is homed during attach
+ * @param context caller supplied device context pointer
+ * @param schedule caller supplied scheduler pointer
+ * @param rate maximum frames committed per second (0: commit every tick)
+ */
+void hd44780_schedule_attach(
+	__in hdcont_t *context,
+	__in hdsched_t *schedule,
+	__in uint8_t rate
+	);
+
+/**
+ * Schedule detach routine
+ * Allows the caller to commit any pending state and detach the refresh 
+ *   scheduler from a specified device context
+ * @param context caller supplied device context pointer
+ */
+void hd44780_schedule_detach(
+	__in hdcont_t *context
+	);
+
+/**
+ * Schedule flush routine
+ * Allows the caller to immediately commit any pending state of a specified 
+ *   device context, regardless of the frame rate
+ * @param context caller supplied device context pointer
+ */
+void hd44780_schedule_flush(
+	__in hdcont_t *context
+	);
+
+/**
+ * Schedule tick routine
+ * Allows the caller to advance the scheduler of a specified device context. 
+ *   Pending state is committed once a frame period has elapsed
+ * @param context caller supplied device context pointer
+ * @param elapsed time since the previous tick (ms)
+ */
+void hd44780_schedule_tick(
+	__in hdcont_t *context,
+	__in uint16_t elapsed
+	);
+
+/***********************************************************************************
+ * ** Console routines **
+ * These routines turn a devices display into a scrolling console. While a 
+ *   console is attached, the display character routines handle newline ('\n'), 
+ *   carriage return ('\r') and backspace ('\b'), and scroll the display up one 
+ *   line (rewriting only the cells that change) instead of clearing it
+ ***********************************************************************************/
+
+/**
+ * Console attach routine
+ * Allows the caller to attach a console line buffer to a specified device context
+ * NOTE: The display is cleared and the cursor is homed during attach
+ * @param context caller supplied device context pointer
+ * @param console caller supplied console line buffer pointer
+ */
+void hd44780_console_attach(
+	__in hdcont_t *context,
+	__in hdcons_t *console
+	);
+
+/**
+ * Console detach routine
+ * Allows the caller to detach the console line buffer from a specified device 
+ *   context. The display contents are left unchanged
+ * @param context caller supplied device context pointer
+ */
+void hd44780_console_detach(
+	__in hdcont_t *context
+	);
+
+/***********************************************************************************
+ * ** Multi-device routines **
+ * These routines drive several independent devices from a single MCU. Instead of 
+ *   waiting for each device to finish its command, transactions are queued per 
+ *   device and interleaved, so one device executes a command while another is 
+ *   being written to
+ * NOTE: These routines rely on the busy flag, so the direction pin of each 
+ *   device must be connected. Queued transactions bypass the refresh scheduler 
+ *   and console, so neither may be attached to a device driven by these routines
+ ***********************************************************************************/
+
+/**
+ * Multi-device attach routine
+ * Allows the caller to attach an initialized device context to a multi-device 
+ *   driver slot. Device contexts with a refresh scheduler or console attached 
+ *   are rejected
+ * @param multi caller supplied multi-device driver pointer
+ * @param index driver slot (0 - MULTI_CONTEXT_MAX - 1)
+ * @param context caller supplied device context pointer (NULL to detach)
+ * @return attach result (0: FAILED, 1: SUCCESS)
+ */
+uint8_t hd44780_multi_attach(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in hdcont_t *context
+	);
+
+/**
+ * Multi-device clear routine
+ * Allows the caller to reset a multi-device driver, detaching all device contexts
+ * NOTE: Any queued transactions are discarded
+ * @param multi caller supplied multi-device driver pointer
+ */
+void hd44780_multi_clear(
+	__out hdmulti_t *multi
+	);
+
+/**
+ * Multi-device command routine
+ * Allows the caller to queue a raw device command. If the queue is full, 
+ *   transactions are serviced until space is available
+ * @param multi caller supplied multi-device driver pointer
+ * @param index driver slot
+ * @param select select control pin value
+ * @param data data value
+ */
+void hd44780_multi_command(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in uint8_t select,
+	__in uint8_t data
+	);
+
+/**
+ * Multi-device cursor set routine
+ * Allows the caller to queue a cursor position (col, row) change
+ * @param multi caller supplied multi-device driver pointer
+ * @param index driver slot
+ * @param column cursor column
+ * @param row cursor row
+ */
+void hd44780_multi_cursor_set(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in uint8_t column,
+	__in uint8_t row
+	);
+
+/**
+ * Multi-device flush routine
+ * Allows the caller to service all devices until every queue is empty
+ * @param multi caller supplied multi-device driver pointer
+ */
+void hd44780_multi_flush(
+	__in hdmulti_t *multi
+	);
+
+/**
+ * Multi-device character routine
+ * Allows the caller to queue a character onto the display of a device
+ * @param multi caller supplied multi-device driver pointer
+ * @param index driver slot
+ * @param input character
+ */
+void hd44780_multi_putc(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in char input
+	);
+
+/**
+ * Multi-device string routine
+ * Allows the caller to queue a string onto the display of a device
+ * @param multi caller supplied multi-device driver pointer
+ * @param index driver slot
+ * @param input caller supplied character pointer
+ */
+void hd44780_multi_puts(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in char *input
+	);
+
+/**
+ * Multi-device service routine
+ * Allows the caller to advance every attached device by at most one 
+ *   transaction, without waiting on any device. Devices still busy are skipped
+ * @param multi caller supplied multi-device driver pointer
+ * @return number of devices still busy or issued a transaction (0: idle)
+ */
+uint8_t hd44780_multi_service(
+	__in hdmulti_t *multi
+	);
+
+/***********************************************************************************
+ * ** Animation routines **
+ * These routines animate custom glyphs. An animated glyph is placed onto the 
+ *   display once; its frames are then advanced by rewriting only the glyph 
+ *   bitmap (CGRAM), so every copy on the display updates at the same time and 
+ *   no display (DDRAM) writes are needed
+ ***********************************************************************************/
+
+/**
+ * Animation add routine
+ * Allows the caller to animate a glyph slot. The first frame is written 
+ *   immediately
+ * NOTE: The frames must remain valid for as long as the animation is in use
+ * @param animation caller supplied animation engine pointer
+ * @param slot glyph slot (0 - GLYPH_MAX - 1)
+ * @param frame caller supplied frame bitmaps (GLYPH_ROW_LEN bytes each)
+ * @param frame_count frame count
+ * @param period time between frames (ms)
+ */
+void hd44780_animation_add(
+	__in hdanim_t *animation,
+	__in uint8_t slot,
+	__in const uint8_t *frame,
+	__in uint8_t frame_count,
+	__in uint16_t period
+	);
+
+/**
+ * Animation initialization routine
+ * Allows the caller to initialize an animation engine for a specified device 
+ *   context
+ * @param animation caller supplied animation engine pointer
+ * @param context caller supplied device context pointer
+ * @param budget maximum glyph updates per tick (each costs GLYPH_ROW_LEN + 1 
+ *   transactions)
+ */
+void hd44780_animation_initialize(
+	__out hdanim_t *animation,
+	__in hdcont_t *context,
+	__in uint8_t budget
+	);
+
+/**
+ * Animation place routine
+ * Allows the caller to place an animated glyph onto the display at (col, row). 
+ *   The cursor position is left unchanged. Positions outside of the display 
+ *   are ignored
+ * @param animation caller supplied animation engine pointer
+ * @param slot glyph slot
+ * @param column glyph column
+ * @param row glyph row
+ */
+void hd44780_animation_place(
+	__in hdanim_t *animation,
+	__in uint8_t slot,
+	__in uint8_t column,
+	__in uint8_t row
+	);
+
+/**
+ * Animation remove routine
+ * Allows the caller to stop animating a glyph slot. The glyph keeps its 
+ *   current frame
+ * @param animation caller supplied animation engine pointer
+ * @param slot glyph slot
+ */
+void hd44780_animation_remove(
+	__in hdanim_t *animation,
+	__in uint8_t slot
+	);
+
+/**
+ * Animation tick routine
+ * Allows the caller to advance every animation whose frame period has elapsed. 
+ *   At most budget glyphs are updated per tick; any others are updated first 
+ *   on the following tick
+ * @param animation caller supplied animation engine pointer
+ * @param elapsed time since the previous tick (ms)
+ */
+void hd44780_animation_tick(
+	__in hdanim_t *animation,
+	__in uint16_t elapsed
+	);
+
+/***********************************************************************************
+ * ** Compositor routines **
+ * These routines composite a base layer and a stack of overlay layers (popups, 
+ *   alerts, etc.) onto a devices display. Each layer is backed by a cell buffer, 
+ *   so showing or hiding an overlay only sends the cells it covers
+ * NOTE: Compositor routines leave the cursor position unchanged
+ ***********************************************************************************/
+
+/**
+ * Compositor add routine
+ * Allows the caller to add an overlay layer on top of all other layers. The 
+ *   layer stays hidden until shown
+ * @param compositor caller supplied compositor pointer
+ * @param layer caller supplied overlay layer pointer
+ * @return add result (0: FAILED, all LAYER_MAX layers are in use, 1: SUCCESS)
+ */
+uint8_t hd44780_compositor_add(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	);
+
+/**
+ * Compositor hide routine
+ * Allows the caller to hide an overlay layer, restoring the cells it covers 
+ *   from the layers below. Layers not added to the compositor are ignored
+ * @param compositor caller supplied compositor pointer
+ * @param layer caller supplied overlay layer pointer
+ */
+void hd44780_compositor_hide(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	);
+
+/**
+ * Compositor initialization routine
+ * Allows the caller to initialize a compositor for a specified device context
+ * NOTE: The display is cleared and the cursor is homed during initialization
+ * @param compositor caller supplied compositor pointer
+ * @param context caller supplied device context pointer
+ */
+void hd44780_compositor_initialize(
+	__out hdcomp_t *compositor,
+	__in hdcont_t *context
+	);
+
+/**
+ * Compositor layer initialization routine
+ * Allows the caller to initialize an overlay layer covering (col, row) through 
+ *   (col + width - 1, row + height - 1)
+ * NOTE: The cell buffer must remain valid for as long as the layer is in use
+ * @param layer caller supplied overlay layer pointer
+ * @param cell caller supplied cell buffer (width * height bytes)
+ * @param column layer column
+ * @param row layer row
+ * @param width layer column count
+ * @param height layer row count
+ */
+void hd44780_compositor_layer_initialize(
+	__out hdlayer_t *layer,
+	__in uint8_t *cell,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in uint8_t width,
+	__in uint8_t height
+	);
+
+/**
+ * Compositor layer string routine
+ * Allows the caller to place a string into an overlay layer at (col, row), 
+ *   relative to the layer. Only visible, changed cells are sent to the device
+ * @param compositor caller supplied compositor pointer
+ * @param layer caller supplied overlay layer pointer
+ * @param column layer relative column
+ * @param row layer relative row
+ * @param input caller supplied character pointer
+ */
+void hd44780_compositor_layer_puts(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in char *input
+	);
+
+/**
+ * Compositor string routine
+ * Allows the caller to place a string into the base layer at (col, row). Only 
+ *   visible, changed cells are sent to the device
+ * @param compositor caller supplied compositor pointer
+ * @param column base layer column
+ * @param row base layer row
+ * @param input caller supplied character pointer
+ */
+void hd44780_compositor_puts(
+	__in hdcomp_t *compositor,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in char *input
+	);
+
+/**
+ * Compositor remove routine
+ * Allows the caller to hide and remove an overlay layer
+ * @param compositor caller supplied compositor pointer
+ * @param layer caller supplied overlay layer pointer
+ */
+void hd44780_compositor_remove(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	);
+
+/**
+ * Compositor show routine
+ * Allows the caller to show an overlay layer, sending the cells it covers. 
+ *   Layers not added to the compositor are ignored
+ * @param compositor caller supplied compositor pointer
+ * @param layer caller supplied overlay layer pointer
+ */
+void hd44780_compositor_show(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	);
+
+/***********************************************************************************
+ * ** Calibration routines **
+ * These routines measure a devices real timing requirements using the busy flag, 
+ *   and persist them to EEPROM. On later initializations, the persisted timing 
+ *   is loaded in place of the controller profile timing. Records are keyed by 
+ *   the panels control port/enable pin and profile
+ * NOTE: These routines rely on the busy flag, so the direction pin of the 
+ *   device must be connected. Execution times are measured with Timer1 (clk / 8). 
+ *   While a measurement runs, the callers Timer1 is paused and its interrupts 
+ *   are masked; its configuration and count are then restored, and any flags 
+ *   raised by the measurement are cleared. The callers Timer1 count therefore 
+ *   does not advance during calibration. On devices without Timer1, calibration 
+ *   always fails
+ ***********************************************************************************/
+
+/**
+ * Calibration routine
+ * Allows the caller to calibrate a specified device context. The enable pulse 
+ *   width is lowered until the panel fails to store data correctly, and the 
+ *   instruction, data and clear execution times are measured. A safety margin 
+ *   is added to each value (the enable pulse width is capped at, and falls back 
+ *   to, the profile value) and the result is stored to EEPROM
+ * NOTE: The display is cleared and the cursor is homed during calibration, 
+ *   which also clears an attached console. Compositor cell buffers are not 
+ *   cleared, so the caller must redraw them afterwards. Calibration fails if a 
+ *   refresh scheduler is attached
+ * @param context caller supplied device context pointer
+ * @return calibration result (0: FAILED, the profile timing is kept, 1: SUCCESS)
+ */
+uint8_t hd44780_calibrate(
+	__in hdcont_t *context
+	);
+
+/**
+ * Calibration clear routine
+ * Allows the caller to discard the persisted timing of a specified device 
+ *   context, reverting it to its controller profile timing
+ * @param context caller supplied device context pointer
+ */
+void hd44780_calibration_clear(
+	__in hdcont_t *context
+	);
+
 /***********************************************************************************
  * ** Device routines **
  * These routines allow lower-level device access
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <avr/eeprom.h>
 #include <util/delay.h>
 #include "../include/hd44780.h"
 
@@ -26,13 +27,15 @@
 #define COMMAND_DISPLAY_SET 0x8
 #define COMMAND_ENTRY_MODE 0x4
 #define COMMAND_FUNCTION_SET 0x28
+#define COMMAND_FUNCTION_RESET 0x3
+#define COMMAND_GLYPH_SET 0x40
+#define COMMAND_OLED_MODE 0x13
 
 #define DDR_OUTPUT_4 0xf
 #define DDR_OUTPUT_8 0xff
 
-#define DELAY_COMMAND 50 // us
-#define DELAY_INITIALIZE 50 // ms
-#define DELAY_LATCH 10 // us
+#define DELAY_RESET_LONG 5 // ms
+#define DELAY_RESET_SHORT 100 // us
 
 #define FLAG_BUSY_4 0x8
 #define FLAG_BUSY_8 0x80
@@ -43,8 +46,36 @@
 #define FLAG_DISPLAY_SHOW 0x4
 #define FLAG_INITIALIZED 0xFF38
 #define FLAG_INTERFACE 0x10
+#define FLAG_OLED_GRAPHIC 0x8
+#define FLAG_OLED_POWER 0x4
+#define FLAG_SCHEDULE_CELL 0x1
+#define FLAG_SCHEDULE_CONTROL 0x2
+#define FLAG_SCHEDULE_CURSOR 0x4
 #define FLAG_SHIFT_RIGHT 0x2
 
+#define CALIBRATION_MAGIC 0x4844
+#define CALIBRATION_MARGIN 2 // value / 2 (50%)
+#define CALIBRATION_MARGIN_MIN 2 // us
+#define CALIBRATION_PATTERN_0 0x55
+#define CALIBRATION_PATTERN_1 0x2a
+#define CALIBRATION_TIMEOUT 10000 // us
+#define CALIBRATION_TIMER_PRESCALE 8 // Timer1 (clk / 8)
+#define CALIBRATION_TIMER_TICK(_US_) \
+	((uint16_t) (((uint32_t) (_US_) * (F_CPU / 1000000UL)) / CALIBRATION_TIMER_PRESCALE))
+#define CALIBRATION_TIMER_US(_TICK_) \
+	((uint16_t) (((uint32_t) (_TICK_) * CALIBRATION_TIMER_PRESCALE) / (F_CPU / 1000000UL)))
+
+#define CELL_EMPTY ' '
+#define CELL_INDEX(_CONT_, _COL_, _ROW_) \
+	(((_ROW_) * (_CONT_)->state.dimension_column) + (_COL_))
+#define CELL_VALID(_CONT_, _COL_, _ROW_) \
+	(((_COL_) < (_CONT_)->state.dimension_column) \
+	&& ((_ROW_) < (_CONT_)->state.dimension_row))
+
+#define CONSOLE_BACKSPACE '\b'
+#define CONSOLE_NEWLINE '\n'
+#define CONSOLE_RETURN '\r'
+
 #define SELECT_COMMAND 0
 #define SELECT_DATA 1
 
@@ -73,55 +104,228 @@ static const uint8_t *DIMESION_ROW_OFF[] = {
 
 #define DIMENSION_ROW_OFFSET(_TYPE_, _ROW_) \
 	((_TYPE_) > DIMENSION_TYPE_MAX ? 0 : \
-	((_ROW_) >= DIMENSION_ROW_LENGTH(_ROW_) ? 0 : \
+	((_ROW_) >= DIMENSION_ROW_LENGTH(_TYPE_) ? 0 : \
 	DIMESION_ROW_OFF[_TYPE_][_ROW_]))
 
-inline void 
+static const hdcont_timing_t PROFILE_TIM[] = {
+	{ 50, 50, 10, 2000, },		// HD44780
+	{ 40, 30, 1, 2000, },		// KS0066
+	{ 10, 1, 1, 3000, },		// WS0010 (busy flag, R/W required)
+	};
+
+#define MAP_LINE(_PORT_, _PIN_) (((_PORT_) << 3) | (_PIN_))
+#define MAP_LINE_PIN(_LINE_) ((_LINE_) & 0x7)
+#define MAP_LINE_PORT(_LINE_) ((_LINE_) >> 3)
+
+#define MULTI_SELECT_BIT(_INDEX_) ((_INDEX_) & 0x7)
+#define MULTI_SELECT_BYTE(_INDEX_) ((_INDEX_) >> 3)
+
+#define PROFILE_TIMING(_TYPE_) \
+	PROFILE_TIM[(_TYPE_) > PROFILE_TYPE_MAX ? PROFILE_HD44780 : (_TYPE_)]
+
+/**
+ * Holds persisted (EEPROM) calibration information
+ */
+typedef struct _hdcalib_t {
+	uint16_t key;				// panel key (control port/enable pin)
+	uint16_t magic;				// record magic
+	uint8_t profile;			// controller profile type
+	hdcont_timing_t timing;			// calibrated timing
+	uint8_t checksum;			// record checksum
+} hdcalib_t;
+
+static hdcalib_t EEMEM CALIBRATION_RECORD[CALIBRATION_SLOT_MAX];
+
+static inline void 
+timing_delay_ms(
+	__in uint16_t delay
+	)
+{
+	while(delay--) {
+		_delay_ms(1);
+	}
+}
+
+static inline void 
+timing_delay_us(
+	__in uint16_t delay
+	)
+{
+	while(delay--) {
+		_delay_us(1);
+	}
+}
+
+static inline uint8_t 
+data_busy(
+	__in hdcont_t *context
+	)
+{
+	uint8_t busy = 0, line;
+
+	if(context) {
+
+		if(context->map) {
+			line = context->map->line[MAP_LINE_D7];
+
+			if(line != MAP_LINE_NONE) {
+				busy = (*context->map->pin[MAP_LINE_PORT(line)] & _BV(MAP_LINE_PIN(line)));
+			}
+		} else if(context->interface) {
+			busy = (*context->comm.pin_data & FLAG_BUSY_8);
+		} else {
+			busy = (*context->comm.pin_data & FLAG_BUSY_4);
+		}
+	}
+
+	return busy;
+}
+
+static inline uint8_t 
+data_read(
+	__in hdcont_t *context
+	)
+{
+	uint8_t data = 0, iter, line;
+
+	if(context) {
+
+		if(context->map) {
+
+			for(iter = (context->interface ? MAP_LINE_D0 : MAP_LINE_D4); iter <= MAP_LINE_D7; 
+					++iter) {
+				line = context->map->line[iter];
+
+				if((line != MAP_LINE_NONE) 
+						&& (*context->map->pin[MAP_LINE_PORT(line)] & _BV(MAP_LINE_PIN(line)))) {
+					data |= _BV(context->interface ? iter : (iter - MAP_LINE_D4));
+				}
+			}
+		} else if(context->interface) {
+			data = *context->comm.pin_data;
+		} else {
+			data = (*context->comm.pin_data & DDR_OUTPUT_4);
+		}
+	}
+
+	return data;
+}
+
+static inline void 
+data_input(
+	__in hdcont_t *context
+	)
+{
+	uint8_t iter;
+
+	if(context) {
+
+		if(context->map) {
+
+			for(iter = 0; iter < MAP_PORT_MAX; ++iter) {
+
+				if(context->map->mask[iter]) {
+					*context->map->ddr[iter] &= ~context->map->mask[iter];
+					*context->map->port[iter] &= ~context->map->mask[iter];
+				}
+			}
+		} else if(context->interface) {
+			*context->comm.ddr_data &= ~DDR_OUTPUT_8;
+			*context->comm.port_data = 0;
+		} else {
+			*context->comm.ddr_data &= ~DDR_OUTPUT_4;
+			*context->comm.port_data &= ~DDR_OUTPUT_4;
+		}
+	}
+}
+
+static inline void 
+data_output(
+	__in hdcont_t *context,
+	__in uint8_t data
+	)
+{
+	uint8_t iter, value;
+
+	if(context) {
+
+		if(context->map) {
+
+			for(iter = 0; iter < MAP_PORT_MAX; ++iter) {
+
+				if(context->map->mask[iter]) {
+
+					if(context->interface) {
+						value = (context->map->table_high[iter][data >> 4] 
+								| context->map->table_low[iter][data & DDR_OUTPUT_4]);
+					} else {
+						value = context->map->table_high[iter][data & DDR_OUTPUT_4];
+					}
+
+					*context->map->ddr[iter] |= context->map->mask[iter];
+					*context->map->port[iter] = ((*context->map->port[iter] 
+							& ~context->map->mask[iter]) | value);
+				}
+			}
+		} else if(context->interface) {
+			*context->comm.ddr_data = DDR_OUTPUT_8;
+			*context->comm.port_data = data;
+		} else {
+			*context->comm.ddr_data |= DDR_OUTPUT_4;
+			*context->comm.port_data &= ~DDR_OUTPUT_4;
+			*context->comm.port_data |= (data & DDR_OUTPUT_4);
+		}
+	}
+}
+
+static inline void 
 busy_wait_4(
 	__in hdcont_t *context
 	)
 {
 	uint8_t busy;
+	uint16_t elapsed = 0;
 
 	if(context) {
-		*context->comm.ddr_data &= ~DDR_OUTPUT_4;
-		*context->comm.port_data &= ~DDR_OUTPUT_4;
+		data_input(context);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
 		*context->comm.port_control |= _BV(context->comm.pin_control_direction);
 
 		do {
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 			*context->comm.port_control |= _BV(context->comm.pin_control_enable);
-			_delay_us(DELAY_LATCH);
-			busy = (*context->comm.port_data & FLAG_BUSY_4);
+			timing_delay_us(context->timing.latch);
+			busy = data_busy(context);
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 			*context->comm.port_control |= _BV(context->comm.pin_control_enable);
-			_delay_us(DELAY_COMMAND);
+			timing_delay_us(context->timing.latch);
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
-		} while(busy);
+			elapsed += ((context->timing.latch << 1) + 1);
+		} while(busy && (elapsed < context->timing.timeout));
 	}
 }
 
-inline void 
+static inline void 
 busy_wait_8(
 	__in hdcont_t *context
 	)
 {
 	uint8_t busy;
+	uint16_t elapsed = 0;
 
 	if(context) {
-		*context->comm.ddr_data &= ~DDR_OUTPUT_8;
-		*context->comm.port_data = 0;
+		data_input(context);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
 		*context->comm.port_control |= _BV(context->comm.pin_control_direction);
 
 		do {
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 			*context->comm.port_control |= _BV(context->comm.pin_control_enable);
-			_delay_us(DELAY_LATCH);
-			busy = (*context->comm.port_data & FLAG_BUSY_8);
+			timing_delay_us(context->timing.latch);
+			busy = data_busy(context);
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
-		} while(busy);
+			elapsed += (context->timing.latch + 1);
+		} while(busy && (elapsed < context->timing.timeout));
 	}
 }
 
@@ -132,12 +336,10 @@ hd44780_command_4_nibble(
 	)
 {
 	if(context) {
-		*context->comm.ddr_data |= DDR_OUTPUT_4;
-		*context->comm.port_data &= ~DDR_OUTPUT_4;
-		*context->comm.port_data |= data;
+		data_output(context, data);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 		*context->comm.port_control |= _BV(context->comm.pin_control_enable);
-		_delay_us(DELAY_COMMAND);
+		timing_delay_us(context->timing.latch);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 	}
 }
@@ -166,10 +368,26 @@ hd44780_command_4(
 
 		hd44780_command_4_nibble(context, data >> 4);
 		hd44780_command_4_nibble(context, data);
+		timing_delay_us(context->timing.command);
 		busy_wait_4(context);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
-		*context->comm.port_data &= ~DDR_OUTPUT_4;
+		data_input(context);
+	}
+}
+
+void 
+hd44780_command_8_byte(
+	__in hdcont_t *context,
+	__in uint8_t data
+	)
+{
+	if(context) {
+		data_output(context, data);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
+		*context->comm.port_control |= _BV(context->comm.pin_control_enable);
+		timing_delay_us(context->timing.latch);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 	}
 }
 
@@ -195,16 +413,103 @@ hd44780_command_8(
 			*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
 		}
 
-		*context->comm.ddr_data = DDR_OUTPUT_8;
-		*context->comm.port_data = data;
+		hd44780_command_8_byte(context, data);
+		timing_delay_us(context->timing.command);
+		busy_wait_8(context);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
+		data_input(context);
+	}
+}
+
+static inline uint8_t 
+command_busy(
+	__in hdcont_t *context
+	)
+{
+	uint8_t busy = 0;
+
+	if(context) {
+		data_input(context);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
+		*context->comm.port_control |= _BV(context->comm.pin_control_direction);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
 		*context->comm.port_control |= _BV(context->comm.pin_control_enable);
-		_delay_us(DELAY_COMMAND);
+		timing_delay_us(context->timing.latch);
+		busy = data_busy(context);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
-		busy_wait_8(context);
+
+		if(!context->interface) {
+			*context->comm.port_control |= _BV(context->comm.pin_control_enable);
+			timing_delay_us(context->timing.latch);
+			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
+		}
+
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
+	}
+
+	return busy;
+}
+
+static inline uint8_t 
+command_read(
+	__in hdcont_t *context
+	)
+{
+	uint8_t data = 0;
+
+	if(context) {
+		data_input(context);
+		*context->comm.port_control |= _BV(context->comm.pin_control_select);
+		*context->comm.port_control |= _BV(context->comm.pin_control_direction);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
+		*context->comm.port_control |= _BV(context->comm.pin_control_enable);
+		timing_delay_us(context->timing.latch);
+		data = data_read(context);
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
+
+		if(!context->interface) {
+			*context->comm.port_control |= _BV(context->comm.pin_control_enable);
+			timing_delay_us(context->timing.latch);
+			data = ((data << 4) | data_read(context));
+			*context->comm.port_control &= ~_BV(context->comm.pin_control_enable);
+			busy_wait_4(context);
+		} else {
+			busy_wait_8(context);
+		}
+
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
 		*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
-		*context->comm.port_data = 0;
+	}
+
+	return data;
+}
+
+static inline void 
+command_issue(
+	__in hdcont_t *context,
+	__in uint8_t select,
+	__in uint8_t data
+	)
+{
+	if(context) {
+
+		if(select) {
+			*context->comm.port_control |= _BV(context->comm.pin_control_select);
+		} else {
+			*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
+		}
+
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_direction);
+
+		if(context->interface) {
+			hd44780_command_8_byte(context, data);
+		} else {
+			hd44780_command_4_nibble(context, data >> 4);
+			hd44780_command_4_nibble(context, data);
+		}
+
+		*context->comm.port_control &= ~_BV(context->comm.pin_control_select);
 	}
 }
 
@@ -226,146 +531,1526 @@ hd44780_command(
 	}
 }
 
-void 
-hd44780_cursor(
+static inline void 
+glyph_write(
 	__in hdcont_t *context,
-	__in uint8_t show,
-	__in uint8_t blink
+	__in uint8_t slot,
+	__in const uint8_t *bitmap
 	)
 {
-	uint8_t data = COMMAND_DISPLAY_SET;
-
-	if(context) {
-
-		if(blink) {
-			data |= FLAG_CURSOR_BLINK;
-		}
+	uint8_t iter;
 
-		if(show) {
-			data |= FLAG_CURSOR_SHOW;
-		}
+	if(context && bitmap) {
+		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+				COMMAND_GLYPH_SET | ((slot % GLYPH_MAX) * GLYPH_ROW_LEN));
 
-		if(context->state.display_show) {
-			data |= FLAG_DISPLAY_SHOW;
+		for(iter = 0; iter < GLYPH_ROW_LEN; ++iter) {
+			hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, bitmap[iter]);
 		}
-
-		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
-		context->state.cursor_blink = blink;
-		context->state.cursor_show = show;
 	}
 }
 
-void 
-hd44780_cursor_home(
+static inline void 
+glyph_restore(
 	__in hdcont_t *context
 	)
 {
 	if(context) {
-		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_CURSOR_HOME);
-		context->state.current_column = 0;
-		context->state.current_row = 0;
+		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+				COMMAND_ADDRESS_SET 
+				| (DIMENSION_ROW_OFFSET(context->dimension, context->state.current_row) 
+				+ context->state.current_column));
 	}
 }
 
-void 
-hd4480_cursor_set(
+static inline void 
+cell_put(
 	__in hdcont_t *context,
-	__in uint8_t column,
-	__in uint8_t row
+	__in uint8_t data
 	)
 {
-	uint8_t address;
-
 	if(context) {
-		address = DIMENSION_ROW_OFFSET(context->dimension, row) + column;
-		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-				COMMAND_ADDRESS_SET | address);
-		context->state.current_column = column;
-		context->state.current_row = row;
+
+		if(context->schedule) {
+
+			if(CELL_VALID(context, context->state.current_column, 
+					context->state.current_row)) {
+				context->schedule->cell[CELL_INDEX(context, context->state.current_column, 
+						context->state.current_row)] = data;
+				context->schedule->dirty |= FLAG_SCHEDULE_CELL;
+			}
+
+			context->schedule->dirty |= FLAG_SCHEDULE_CURSOR;
+		} else {
+			hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, data);
+		}
+
+		++context->state.current_column;
 	}
 }
 
-void 
-hd44780_display(
+static inline void 
+cell_set(
 	__in hdcont_t *context,
-	__in uint8_t show
+	__in uint8_t column,
+	__in uint8_t row,
+	__in uint8_t data
 	)
 {
-	uint8_t data = COMMAND_DISPLAY_SET;
-
 	if(context) {
 
-		if(show) {
-			data |= FLAG_DISPLAY_SHOW;
-		}
-
-		if(context->state.cursor_blink) {
-			data |= FLAG_CURSOR_BLINK;
-		}
-
-		if(context->state.cursor_show) {
-			data |= FLAG_CURSOR_SHOW;
+		if((context->state.current_column != column) 
+				|| (context->state.current_row != row)) {
+			hd4480_cursor_set(context, column, row);
 		}
 
-		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
-		context->state.display_show = show;
+		cell_put(context, data);
 	}
 }
 
-void 
-hd44780_display_clear(
+static inline void 
+console_scroll(
 	__in hdcont_t *context
 	)
 {
-	if(context) {
-		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_DISPLAY_CLEAR);
+	uint8_t column, data, index, row;
+
+	if(context && context->console) {
+
+		for(row = 0; row < context->state.dimension_row; ++row) {
+
+			for(column = 0; column < context->state.dimension_column; ++column) {
+				index = CELL_INDEX(context, column, row);
+
+				if(row < (context->state.dimension_row - 1)) {
+					data = context->console->cell[index + context->state.dimension_column];
+				} else {
+					data = CELL_EMPTY;
+				}
+
+				if(data != context->console->cell[index]) {
+					context->console->cell[index] = data;
+					cell_set(context, column, row, data);
+				}
+			}
+		}
 	}
 }
 
-void 
-hd44780_display_putc(
-	__in hdcont_t *context,
-	__in char input
+static inline void 
+console_newline(
+	__in hdcont_t *context
 	)
 {
-	if(context) {
+	uint8_t row;
 
-		if((context->state.current_column >= context->state.dimension_column)
-				&& (context->state.current_row >= (context->state.dimension_row - 1))) {
-			hd44780_display_clear(context);
-			hd44780_cursor_home(context);
-		} else if(context->state.current_column >= context->state.dimension_column) {
-			context->state.current_column = 0;			
-			hd4480_cursor_set(context, context->state.current_column, 
-					++context->state.current_row);
+	if(context && context->console) {
+		row = context->state.current_row;
+
+		if((row + 1) >= context->state.dimension_row) {
+			console_scroll(context);
+		} else {
+			++row;
 		}
 
-		hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, input);
-		++context->state.current_column;
+		if((context->state.current_column != 0) || (context->state.current_row != row)) {
+			hd4480_cursor_set(context, 0, row);
+		}
 	}
 }
 
-void 
-hd44780_display_puts(
+static inline void 
+console_putc(
 	__in hdcont_t *context,
-	__in char *input
+	__in char input
 	)
 {
-	if(context && input) {
+	uint8_t column;
 
-		while(*input != '\0') {
-			hd44780_display_putc(context, *input++);
-		}
-	}
-}
+	if(context && context->console) {
 
-void 
-_hd44780_initialize(
+		switch(input) {
+			case CONSOLE_BACKSPACE:
+				column = context->state.current_column;
+
+				if(column) {
+
+					if(column > context->state.dimension_column) {
+						column = context->state.dimension_column;
+					}
+
+					--column;
+
+					if(CELL_VALID(context, column, context->state.current_row)) {
+						context->console->cell[CELL_INDEX(context, column, 
+								context->state.current_row)] = CELL_EMPTY;
+					}
+
+					cell_set(context, column, context->state.current_row, CELL_EMPTY);
+					hd4480_cursor_set(context, column, context->state.current_row);
+				}
+				break;
+			case CONSOLE_NEWLINE:
+				console_newline(context);
+				break;
+			case CONSOLE_RETURN:
+
+				if(context->state.current_column) {
+					hd4480_cursor_set(context, 0, context->state.current_row);
+				}
+				break;
+			default:
+
+				if(context->state.current_column >= context->state.dimension_column) {
+					console_newline(context);
+				}
+
+				if(CELL_VALID(context, context->state.current_column, 
+						context->state.current_row)) {
+					context->console->cell[CELL_INDEX(context, 
+							context->state.current_column, 
+							context->state.current_row)] = input;
+				}
+
+				cell_put(context, input);
+				break;
+		}
+	}
+}
+
+void 
+hd44780_cursor(
+	__in hdcont_t *context,
+	__in uint8_t show,
+	__in uint8_t blink
+	)
+{
+	uint8_t data = COMMAND_DISPLAY_SET;
+
+	if(context) {
+
+		if(blink) {
+			data |= FLAG_CURSOR_BLINK;
+		}
+
+		if(show) {
+			data |= FLAG_CURSOR_SHOW;
+		}
+
+		if(context->state.display_show) {
+			data |= FLAG_DISPLAY_SHOW;
+		}
+
+		if(context->schedule) {
+			context->schedule->dirty |= FLAG_SCHEDULE_CONTROL;
+		} else {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
+		}
+
+		context->state.cursor_blink = blink;
+		context->state.cursor_show = show;
+	}
+}
+
+void 
+hd44780_cursor_home(
+	__in hdcont_t *context
+	)
+{
+	if(context) {
+		if(context->schedule) {
+			context->schedule->dirty |= FLAG_SCHEDULE_CURSOR;
+		} else {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_CURSOR_HOME);
+		}
+
+		context->state.current_column = 0;
+		context->state.current_row = 0;
+	}
+}
+
+void 
+hd4480_cursor_set(
+	__in hdcont_t *context,
+	__in uint8_t column,
+	__in uint8_t row
+	)
+{
+	uint8_t address;
+
+	if(context) {
+		if(context->schedule) {
+			context->schedule->dirty |= FLAG_SCHEDULE_CURSOR;
+		} else {
+			address = DIMENSION_ROW_OFFSET(context->dimension, row) + column;
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+					COMMAND_ADDRESS_SET | address);
+		}
+
+		context->state.current_column = column;
+		context->state.current_row = row;
+	}
+}
+
+void 
+hd44780_display(
+	__in hdcont_t *context,
+	__in uint8_t show
+	)
+{
+	uint8_t data = COMMAND_DISPLAY_SET;
+
+	if(context) {
+
+		if(show) {
+			data |= FLAG_DISPLAY_SHOW;
+		}
+
+		if(context->state.cursor_blink) {
+			data |= FLAG_CURSOR_BLINK;
+		}
+
+		if(context->state.cursor_show) {
+			data |= FLAG_CURSOR_SHOW;
+		}
+
+		if(context->schedule) {
+			context->schedule->dirty |= FLAG_SCHEDULE_CONTROL;
+		} else {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
+		}
+
+		context->state.display_show = show;
+	}
+}
+
+void 
+hd44780_display_clear(
+	__in hdcont_t *context
+	)
+{
+	uint8_t iter;
+
+	if(context) {
+
+		if(context->schedule) {
+
+			for(iter = 0; iter < DIMENSION_CELL_MAX; ++iter) {
+				context->schedule->cell[iter] = CELL_EMPTY;
+			}
+
+			context->schedule->dirty |= FLAG_SCHEDULE_CELL;
+		} else {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_DISPLAY_CLEAR);
+		}
+
+		if(context->console) {
+
+			for(iter = 0; iter < DIMENSION_CELL_MAX; ++iter) {
+				context->console->cell[iter] = CELL_EMPTY;
+			}
+		}
+	}
+}
+
+void 
+hd44780_display_glyph(
+	__in hdcont_t *context,
+	__in uint8_t slot,
+	__in const uint8_t *bitmap
+	)
+{
+	if(context && bitmap) {
+		glyph_write(context, slot, bitmap);
+		glyph_restore(context);
+	}
+}
+
+void 
+hd44780_display_putc(
+	__in hdcont_t *context,
+	__in char input
+	)
+{
+	if(context) {
+
+		if(context->console) {
+			console_putc(context, input);
+		} else {
+
+			if((context->state.current_column >= context->state.dimension_column)
+					&& (context->state.current_row >= (context->state.dimension_row - 1))) {
+				hd44780_display_clear(context);
+				hd44780_cursor_home(context);
+			} else if(context->state.current_column >= context->state.dimension_column) {
+				context->state.current_column = 0;			
+				hd4480_cursor_set(context, context->state.current_column, 
+						++context->state.current_row);
+			}
+
+			cell_put(context, input);
+		}
+	}
+}
+
+void 
+hd44780_display_puts(
+	__in hdcont_t *context,
+	__in char *input
+	)
+{
+	if(context && input) {
+
+		while(*input != '\0') {
+			hd44780_display_putc(context, *input++);
+		}
+	}
+}
+
+void 
+hd44780_oled(
+	__in hdcont_t *context,
+	__in uint8_t mode,
+	__in uint8_t power
+	)
+{
+	uint8_t data = COMMAND_OLED_MODE;
+
+	if(context && (context->profile == PROFILE_WS0010)) {
+
+		if(mode) {
+			data |= FLAG_OLED_GRAPHIC;
+		}
+
+		if(power) {
+			data |= FLAG_OLED_POWER;
+		}
+
+		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
+	}
+}
+
+static inline uint8_t 
+schedule_control(
+	__in hdcont_t *context
+	)
+{
+	uint8_t data = COMMAND_DISPLAY_SET;
+
+	if(context) {
+
+		if(context->state.cursor_blink) {
+			data |= FLAG_CURSOR_BLINK;
+		}
+
+		if(context->state.cursor_show) {
+			data |= FLAG_CURSOR_SHOW;
+		}
+
+		if(context->state.display_show) {
+			data |= FLAG_DISPLAY_SHOW;
+		}
+	}
+
+	return data;
+}
+
+void 
+hd44780_schedule_attach(
+	__in hdcont_t *context,
+	__in hdsched_t *schedule,
+	__in uint8_t rate
+	)
+{
+	uint8_t iter;
+
+	if(context && schedule) {
+		context->schedule = NULL;
+		hd44780_display_clear(context);
+		hd44780_cursor_home(context);
+
+		for(iter = 0; iter < DIMENSION_CELL_MAX; ++iter) {
+			schedule->cell[iter] = CELL_EMPTY;
+			schedule->cell_commit[iter] = CELL_EMPTY;
+		}
+
+		schedule->control = schedule_control(context);
+		schedule->dirty = 0;
+		schedule->elapsed = 0;
+		schedule->period = (rate ? (1000 / rate) : 0);
+		context->schedule = schedule;
+	}
+}
+
+void 
+hd44780_schedule_detach(
+	__in hdcont_t *context
+	)
+{
+	if(context && context->schedule) {
+		hd44780_schedule_flush(context);
+		context->schedule = NULL;
+	}
+}
+
+void 
+hd44780_schedule_flush(
+	__in hdcont_t *context
+	)
+{
+	uint8_t column, data, index = 0, row, sequential;
+	hdsched_t *schedule;
+
+	if(context && context->schedule) {
+		schedule = context->schedule;
+
+		if(schedule->dirty & FLAG_SCHEDULE_CELL) {
+
+			for(row = 0; row < context->state.dimension_row; ++row) {
+				sequential = 0;
+
+				for(column = 0; column < context->state.dimension_column; ++column, ++index) {
+					data = schedule->cell[index];
+
+					if(data == schedule->cell_commit[index]) {
+						sequential = 0;
+						continue;
+					}
+
+					if(!sequential) {
+						hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+								COMMAND_ADDRESS_SET 
+								| (DIMENSION_ROW_OFFSET(context->dimension, row) 
+								+ column));
+						sequential = 1;
+					}
+
+					hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, data);
+					schedule->cell_commit[index] = data;
+					schedule->dirty |= FLAG_SCHEDULE_CURSOR;
+				}
+			}
+		}
+
+		data = schedule_control(context);
+
+		if(data != schedule->control) {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, data);
+			schedule->control = data;
+		}
+
+		if(schedule->dirty & FLAG_SCHEDULE_CURSOR) {
+			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+					COMMAND_ADDRESS_SET 
+					| (DIMENSION_ROW_OFFSET(context->dimension, 
+					context->state.current_row) + context->state.current_column));
+		}
+
+		schedule->dirty = 0;
+	}
+}
+
+void 
+hd44780_schedule_tick(
+	__in hdcont_t *context,
+	__in uint16_t elapsed
+	)
+{
+	hdsched_t *schedule;
+
+	if(context && context->schedule) {
+		schedule = context->schedule;
+
+		if((UINT16_MAX - schedule->elapsed) < elapsed) {
+			schedule->elapsed = UINT16_MAX;
+		} else {
+			schedule->elapsed += elapsed;
+		}
+
+		if(schedule->elapsed >= schedule->period) {
+			schedule->elapsed = 0;
+
+			if(schedule->dirty) {
+				hd44780_schedule_flush(context);
+			}
+		}
+	}
+}
+
+static inline void 
+map_build(
+	__in hdmap_t *map,
+	__in uint8_t interface
+	)
+{
+	uint8_t iter, line, pin, port, value;
+
+	if(map) {
+
+		for(port = 0; port < MAP_PORT_MAX; ++port) {
+			map->mask[port] = 0;
+
+			for(value = 0; value < MAP_TABLE_LEN; ++value) {
+				map->table_high[port][value] = 0;
+				map->table_low[port][value] = 0;
+			}
+		}
+
+		for(iter = (interface ? MAP_LINE_D0 : MAP_LINE_D4); iter <= MAP_LINE_D7; ++iter) {
+			line = map->line[iter];
+
+			if(line == MAP_LINE_NONE) {
+				continue;
+			}
+
+			port = MAP_LINE_PORT(line);
+			pin = _BV(MAP_LINE_PIN(line));
+			map->mask[port] |= pin;
+
+			for(value = 0; value < MAP_TABLE_LEN; ++value) {
+
+				if(value & _BV(iter & 0x3)) {
+
+					if(iter >= MAP_LINE_D4) {
+						map->table_high[port][value] |= pin;
+					} else {
+						map->table_low[port][value] |= pin;
+					}
+				}
+			}
+		}
+	}
+}
+
+void 
+hd44780_map_clear(
+	__out hdmap_t *map
+	)
+{
+	uint8_t iter;
+
+	if(map) {
+
+		for(iter = 0; iter < MAP_PORT_MAX; ++iter) {
+			map->ddr[iter] = NULL;
+			map->pin[iter] = NULL;
+			map->port[iter] = NULL;
+			map->mask[iter] = 0;
+		}
+
+		for(iter = 0; iter < MAP_LINE_MAX; ++iter) {
+			map->line[iter] = MAP_LINE_NONE;
+		}
+	}
+}
+
+void 
+_hd44780_map_line(
+	__in hdmap_t *map,
+	__in uint8_t line,
+	__in volatile uint8_t *ddr,
+	__in volatile uint8_t *pin,
+	__in volatile uint8_t *port,
+	__in uint8_t pin_data
+	)
+{
+	uint8_t iter;
+
+	if(map && ddr && pin && port && (line < MAP_LINE_MAX)) {
+
+		for(iter = 0; iter < MAP_PORT_MAX; ++iter) {
+
+			if(!map->port[iter]) {
+				map->ddr[iter] = ddr;
+				map->pin[iter] = pin;
+				map->port[iter] = port;
+			}
+
+			if(map->port[iter] == port) {
+				map->line[line] = MAP_LINE(iter, pin_data);
+				break;
+			}
+		}
+	}
+}
+
+void 
+hd44780_console_attach(
+	__in hdcont_t *context,
+	__in hdcons_t *console
+	)
+{
+	if(context && console) {
+		context->console = console;
+		hd44780_display_clear(context);
+		hd44780_cursor_home(context);
+	}
+}
+
+void 
+hd44780_console_detach(
+	__in hdcont_t *context
+	)
+{
+	if(context) {
+		context->console = NULL;
+	}
+}
+
+uint8_t 
+hd44780_multi_attach(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in hdcont_t *context
+	)
+{
+	uint8_t iter, result = 0;
+	hdmulti_queue_t *queue;
+
+	if(multi && (index < MULTI_CONTEXT_MAX) 
+			&& (!context || (!context->schedule && !context->console))) {
+		queue = &multi->queue[index];
+		queue->count = 0;
+		queue->elapsed = 0;
+		queue->head = 0;
+		queue->pending = 0;
+
+		for(iter = 0; iter < sizeof(queue->select); ++iter) {
+			queue->select[iter] = 0;
+		}
+
+		multi->context[index] = context;
+		result = 1;
+	}
+
+	return result;
+}
+
+void 
+hd44780_multi_clear(
+	__out hdmulti_t *multi
+	)
+{
+	uint8_t iter;
+
+	if(multi) {
+
+		for(iter = 0; iter < MULTI_CONTEXT_MAX; ++iter) {
+			hd44780_multi_attach(multi, iter, NULL);
+		}
+	}
+}
+
+void 
+hd44780_multi_command(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in uint8_t select,
+	__in uint8_t data
+	)
+{
+	uint8_t tail;
+	hdmulti_queue_t *queue;
+
+	if(multi && (index < MULTI_CONTEXT_MAX) && multi->context[index]) {
+		queue = &multi->queue[index];
+
+		while(queue->count >= MULTI_QUEUE_LEN) {
+			hd44780_multi_service(multi);
+		}
+
+		tail = ((queue->head + queue->count) % MULTI_QUEUE_LEN);
+		queue->data[tail] = data;
+
+		if(select) {
+			queue->select[MULTI_SELECT_BYTE(tail)] |= _BV(MULTI_SELECT_BIT(tail));
+		} else {
+			queue->select[MULTI_SELECT_BYTE(tail)] &= ~_BV(MULTI_SELECT_BIT(tail));
+		}
+
+		++queue->count;
+	}
+}
+
+void 
+hd44780_multi_cursor_set(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in uint8_t column,
+	__in uint8_t row
+	)
+{
+	hdcont_t *context;
+
+	if(multi && (index < MULTI_CONTEXT_MAX) && multi->context[index]) {
+		context = multi->context[index];
+		hd44780_multi_command(multi, index, SELECT_COMMAND, COMMAND_ADDRESS_SET 
+				| (DIMENSION_ROW_OFFSET(context->dimension, row) + column));
+		context->state.current_column = column;
+		context->state.current_row = row;
+	}
+}
+
+void 
+hd44780_multi_flush(
+	__in hdmulti_t *multi
+	)
+{
+	if(multi) {
+
+		while(hd44780_multi_service(multi));
+	}
+}
+
+void 
+hd44780_multi_putc(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in char input
+	)
+{
+	hdcont_t *context;
+
+	if(multi && (index < MULTI_CONTEXT_MAX) && multi->context[index]) {
+		context = multi->context[index];
+
+		if((context->state.current_column >= context->state.dimension_column)
+				&& (context->state.current_row >= (context->state.dimension_row - 1))) {
+			hd44780_multi_command(multi, index, SELECT_COMMAND, COMMAND_DISPLAY_CLEAR);
+			hd44780_multi_cursor_set(multi, index, 0, 0);
+		} else if(context->state.current_column >= context->state.dimension_column) {
+			hd44780_multi_cursor_set(multi, index, 0, context->state.current_row + 1);
+		}
+
+		hd44780_multi_command(multi, index, SELECT_DATA, input);
+		++context->state.current_column;
+	}
+}
+
+void 
+hd44780_multi_puts(
+	__in hdmulti_t *multi,
+	__in uint8_t index,
+	__in char *input
+	)
+{
+	if(multi && input) {
+
+		while(*input != '\0') {
+			hd44780_multi_putc(multi, index, *input++);
+		}
+	}
+}
+
+uint8_t 
+hd44780_multi_service(
+	__in hdmulti_t *multi
+	)
+{
+	uint8_t iter, result = 0;
+	hdcont_t *context;
+	hdmulti_queue_t *queue;
+
+	if(multi) {
+
+		for(iter = 0; iter < MULTI_CONTEXT_MAX; ++iter) {
+			context = multi->context[iter];
+
+			if(!context) {
+				continue;
+			}
+
+			queue = &multi->queue[iter];
+
+			if(queue->pending) {
+
+				if(command_busy(context) && (queue->elapsed < context->timing.timeout)) {
+					queue->elapsed += ((context->timing.latch << 1) + 1);
+					++result;
+					continue;
+				}
+
+				queue->pending = 0;
+			}
+
+			if(queue->count) {
+				command_issue(context, ((queue->select[MULTI_SELECT_BYTE(queue->head)] 
+						>> MULTI_SELECT_BIT(queue->head)) & 1), queue->data[queue->head]);
+				queue->elapsed = 0;
+				queue->head = ((queue->head + 1) % MULTI_QUEUE_LEN);
+				queue->pending = 1;
+				--queue->count;
+				++result;
+			}
+		}
+	}
+
+	return result;
+}
+
+void 
+hd44780_animation_add(
+	__in hdanim_t *animation,
+	__in uint8_t slot,
+	__in const uint8_t *frame,
+	__in uint8_t frame_count,
+	__in uint16_t period
+	)
+{
+	hdanim_slot_t *entry;
+
+	if(animation && animation->context && frame && frame_count && (slot < GLYPH_MAX)) {
+		entry = &animation->slot[slot];
+		entry->elapsed = 0;
+		entry->frame = frame;
+		entry->frame_count = frame_count;
+		entry->frame_current = 0;
+		entry->period = period;
+		hd44780_display_glyph(animation->context, slot, entry->frame);
+	}
+}
+
+void 
+hd44780_animation_initialize(
+	__out hdanim_t *animation,
+	__in hdcont_t *context,
+	__in uint8_t budget
+	)
+{
+	uint8_t iter;
+
+	if(animation) {
+		animation->budget = (budget ? budget : 1);
+		animation->context = context;
+		animation->next = 0;
+
+		for(iter = 0; iter < GLYPH_MAX; ++iter) {
+			hd44780_animation_remove(animation, iter);
+		}
+	}
+}
+
+void 
+hd44780_animation_place(
+	__in hdanim_t *animation,
+	__in uint8_t slot,
+	__in uint8_t column,
+	__in uint8_t row
+	)
+{
+	uint8_t column_current, row_current;
+	hdcont_t *context;
+
+	if(animation && animation->context && (slot < GLYPH_MAX) 
+			&& CELL_VALID(animation->context, column, row)) {
+		context = animation->context;
+		column_current = context->state.current_column;
+		row_current = context->state.current_row;
+		cell_set(context, column, row, slot);
+		hd4480_cursor_set(context, column_current, row_current);
+	}
+}
+
+void 
+hd44780_animation_remove(
+	__in hdanim_t *animation,
+	__in uint8_t slot
+	)
+{
+	hdanim_slot_t *entry;
+
+	if(animation && (slot < GLYPH_MAX)) {
+		entry = &animation->slot[slot];
+		entry->elapsed = 0;
+		entry->frame = NULL;
+		entry->frame_count = 0;
+		entry->frame_current = 0;
+		entry->period = 0;
+	}
+}
+
+void 
+hd44780_animation_tick(
+	__in hdanim_t *animation,
+	__in uint16_t elapsed
+	)
+{
+	uint8_t iter, slot, updated = 0;
+	hdanim_slot_t *entry;
+
+	if(animation && animation->context) {
+
+		for(iter = 0; iter < GLYPH_MAX; ++iter) {
+			entry = &animation->slot[iter];
+
+			if(!entry->frame) {
+				continue;
+			}
+
+			if((UINT16_MAX - entry->elapsed) < elapsed) {
+				entry->elapsed = UINT16_MAX;
+			} else {
+				entry->elapsed += elapsed;
+			}
+		}
+
+		for(iter = 0; (iter < GLYPH_MAX) && (updated < animation->budget); ++iter) {
+			slot = ((animation->next + iter) % GLYPH_MAX);
+			entry = &animation->slot[slot];
+
+			if(!entry->frame || (entry->elapsed < entry->period)) {
+				continue;
+			}
+
+			entry->elapsed = 0;
+			entry->frame_current = ((entry->frame_current + 1) % entry->frame_count);
+			glyph_write(animation->context, slot, 
+					entry->frame + (entry->frame_current * GLYPH_ROW_LEN));
+			animation->next = ((slot + 1) % GLYPH_MAX);
+			++updated;
+		}
+
+		if(updated) {
+			glyph_restore(animation->context);
+		}
+	}
+}
+
+static inline uint8_t 
+compositor_find(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	)
+{
+	uint8_t iter;
+
+	for(iter = 0; iter < LAYER_MAX; ++iter) {
+
+		if(compositor->layer[iter] == layer) {
+			break;
+		}
+	}
+
+	return iter;
+}
+
+static inline uint8_t 
+compositor_resolve(
+	__in hdcomp_t *compositor,
+	__in uint8_t column,
+	__in uint8_t row
+	)
+{
+	uint8_t iter = LAYER_MAX;
+	hdlayer_t *layer;
+
+	while(iter--) {
+		layer = compositor->layer[iter];
+
+		if(layer && layer->visible && (column >= layer->column) && (row >= layer->row) 
+				&& ((column - layer->column) < layer->width) 
+				&& ((row - layer->row) < layer->height)) {
+			return layer->cell[((row - layer->row) * layer->width) 
+					+ (column - layer->column)];
+		}
+	}
+
+	return compositor->cell[CELL_INDEX(compositor->context, column, row)];
+}
+
+static inline void 
+compositor_refresh(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer,
+	__in uint8_t visible
+	)
+{
+	uint8_t column, data, previous, row;
+	hdcont_t *context = compositor->context;
+
+	for(row = layer->row; (row < (layer->row + layer->height)) 
+			&& (row < context->state.dimension_row); ++row) {
+
+		for(column = layer->column; (column < (layer->column + layer->width)) 
+				&& (column < context->state.dimension_column); ++column) {
+			layer->visible = !visible;
+			previous = compositor_resolve(compositor, column, row);
+			layer->visible = visible;
+			data = compositor_resolve(compositor, column, row);
+
+			if(data != previous) {
+				cell_set(context, column, row, data);
+			}
+		}
+	}
+
+	layer->visible = visible;
+}
+
+static inline void 
+compositor_write(
+	__in hdcomp_t *compositor,
+	__in uint8_t *cell,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in uint8_t data
+	)
+{
+	uint8_t previous;
+
+	previous = compositor_resolve(compositor, column, row);
+	*cell = data;
+	data = compositor_resolve(compositor, column, row);
+
+	if(data != previous) {
+		cell_set(compositor->context, column, row, data);
+	}
+}
+
+static inline void 
+compositor_restore(
+	__in hdcomp_t *compositor,
+	__in uint8_t column,
+	__in uint8_t row
+	)
+{
+	hdcont_t *context = compositor->context;
+
+	if((context->state.current_column != column) || (context->state.current_row != row)) {
+		hd4480_cursor_set(context, column, row);
+	}
+}
+
+uint8_t 
+hd44780_compositor_add(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	)
+{
+	uint8_t iter, result = 0;
+
+	if(compositor && layer) {
+		hd44780_compositor_remove(compositor, layer);
+		iter = compositor_find(compositor, NULL);
+
+		if(iter < LAYER_MAX) {
+			compositor->layer[iter] = layer;
+			result = 1;
+		}
+	}
+
+	return result;
+}
+
+void 
+hd44780_compositor_hide(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	)
+{
+	uint8_t column, row;
+
+	if(compositor && compositor->context && layer && layer->visible 
+			&& (compositor_find(compositor, layer) < LAYER_MAX)) {
+		column = compositor->context->state.current_column;
+		row = compositor->context->state.current_row;
+		compositor_refresh(compositor, layer, 0);
+		compositor_restore(compositor, column, row);
+	}
+}
+
+void 
+hd44780_compositor_initialize(
+	__out hdcomp_t *compositor,
+	__in hdcont_t *context
+	)
+{
+	uint8_t iter;
+
+	if(compositor && context) {
+		compositor->context = context;
+
+		for(iter = 0; iter < DIMENSION_CELL_MAX; ++iter) {
+			compositor->cell[iter] = CELL_EMPTY;
+		}
+
+		for(iter = 0; iter < LAYER_MAX; ++iter) {
+			compositor->layer[iter] = NULL;
+		}
+
+		hd44780_display_clear(context);
+		hd44780_cursor_home(context);
+	}
+}
+
+void 
+hd44780_compositor_layer_initialize(
+	__out hdlayer_t *layer,
+	__in uint8_t *cell,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in uint8_t width,
+	__in uint8_t height
+	)
+{
+	uint16_t iter;
+
+	if(layer && cell) {
+		layer->cell = cell;
+		layer->column = column;
+		layer->height = height;
+		layer->row = row;
+		layer->visible = 0;
+		layer->width = width;
+
+		for(iter = 0; iter < (width * height); ++iter) {
+			layer->cell[iter] = CELL_EMPTY;
+		}
+	}
+}
+
+void 
+hd44780_compositor_layer_puts(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in char *input
+	)
+{
+	hdcont_t *context;
+	uint8_t column_current, row_current;
+
+	if(compositor && compositor->context && layer && input && (row < layer->height)) {
+		context = compositor->context;
+		column_current = context->state.current_column;
+		row_current = context->state.current_row;
+
+		while((*input != '\0') && (column < layer->width)) {
+
+			if(layer->visible && ((layer->column + column) < context->state.dimension_column) 
+					&& ((layer->row + row) < context->state.dimension_row)) {
+				compositor_write(compositor, &layer->cell[(row * layer->width) + column], 
+						layer->column + column, layer->row + row, *input++);
+			} else {
+				layer->cell[(row * layer->width) + column] = *input++;
+			}
+
+			++column;
+		}
+
+		compositor_restore(compositor, column_current, row_current);
+	}
+}
+
+void 
+hd44780_compositor_puts(
+	__in hdcomp_t *compositor,
+	__in uint8_t column,
+	__in uint8_t row,
+	__in char *input
+	)
+{
+	hdcont_t *context;
+	uint8_t column_current, row_current;
+
+	if(compositor && compositor->context && input) {
+		context = compositor->context;
+		column_current = context->state.current_column;
+		row_current = context->state.current_row;
+
+		if(row < context->state.dimension_row) {
+
+			while((*input != '\0') && (column < context->state.dimension_column)) {
+				compositor_write(compositor, &compositor->cell[CELL_INDEX(context, column, row)], 
+						column, row, *input++);
+				++column;
+			}
+		}
+
+		compositor_restore(compositor, column_current, row_current);
+	}
+}
+
+void 
+hd44780_compositor_remove(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	)
+{
+	uint8_t iter;
+
+	if(compositor && layer) {
+		hd44780_compositor_hide(compositor, layer);
+		iter = compositor_find(compositor, layer);
+
+		if(iter < LAYER_MAX) {
+
+			for(; iter < (LAYER_MAX - 1); ++iter) {
+				compositor->layer[iter] = compositor->layer[iter + 1];
+			}
+
+			compositor->layer[LAYER_MAX - 1] = NULL;
+		}
+	}
+}
+
+void 
+hd44780_compositor_show(
+	__in hdcomp_t *compositor,
+	__in hdlayer_t *layer
+	)
+{
+	uint8_t column, row;
+
+	if(compositor && compositor->context && layer && !layer->visible 
+			&& (compositor_find(compositor, layer) < LAYER_MAX)) {
+		column = compositor->context->state.current_column;
+		row = compositor->context->state.current_row;
+		compositor_refresh(compositor, layer, 1);
+		compositor_restore(compositor, column, row);
+	}
+}
+
+static inline uint8_t 
+calibration_checksum(
+	__in const hdcalib_t *record
+	)
+{
+	uint8_t iter, result = 0;
+
+	for(iter = 0; iter < offsetof(hdcalib_t, checksum); ++iter) {
+		result += ((const uint8_t *) record)[iter];
+	}
+
+	return ~result;
+}
+
+static inline uint16_t 
+calibration_key(
+	__in hdcont_t *context
+	)
+{
+	return ((((uint16_t) (uintptr_t) context->comm.port_control) << 3) 
+			| context->comm.pin_control_enable);
+}
+
+static inline uint16_t 
+calibration_execute(
+	__in hdcont_t *context,
+	__in uint8_t select,
+	__in uint8_t data
+	)
+{
+	uint16_t elapsed = CALIBRATION_TIMEOUT;
+#if defined(TCNT1) && defined(TIMSK1)
+	uint8_t control_a, control_b, flag, mask;
+	uint16_t count;
+
+	control_a = TCCR1A;
+	control_b = TCCR1B;
+	count = TCNT1;
+	flag = TIFR1;
+	mask = TIMSK1;
+	TIMSK1 = 0;
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TCNT1 = 0;
+	command_issue(context, select, data);
+	TCCR1B = _BV(CS11);
+
+	while(command_busy(context) 
+			&& (TCNT1 < CALIBRATION_TIMER_TICK(CALIBRATION_TIMEOUT)));
+
+	elapsed = CALIBRATION_TIMER_US(TCNT1);
+	TCCR1B = 0;
+	TCNT1 = count;
+	TIFR1 = (TIFR1 & ~flag);
+	TCCR1A = control_a;
+	TCCR1B = control_b;
+	TIMSK1 = mask;
+#else
+	hd44780_command(context, select, FLAG_DIRECTION_OUTPUT, data);
+#endif // TCNT1 && TIMSK1
+
+	return elapsed;
+}
+
+static inline uint8_t 
+calibration_latch(
+	__in hdcont_t *context,
+	__in uint8_t latch
+	)
+{
+	uint8_t latch_current, result;
+
+	latch_current = context->timing.latch;
+	hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_ADDRESS_SET);
+	context->timing.latch = latch;
+	hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, CALIBRATION_PATTERN_0);
+	hd44780_command(context, SELECT_DATA, FLAG_DIRECTION_OUTPUT, CALIBRATION_PATTERN_1);
+	context->timing.latch = latch_current;
+	hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, COMMAND_ADDRESS_SET);
+	result = (command_read(context) == CALIBRATION_PATTERN_0);
+	result = ((command_read(context) == CALIBRATION_PATTERN_1) && result);
+
+	return result;
+}
+
+static inline uint8_t 
+calibration_load(
+	__in hdcont_t *context
+	)
+{
+	uint8_t iter, result = 0;
+	uint16_t key;
+	hdcalib_t record;
+
+	if(context) {
+		key = calibration_key(context);
+
+		for(iter = 0; iter < CALIBRATION_SLOT_MAX; ++iter) {
+			eeprom_read_block(&record, &CALIBRATION_RECORD[iter], sizeof(hdcalib_t));
+
+			if((record.magic == CALIBRATION_MAGIC) && (record.key == key) 
+					&& (record.profile == context->profile) 
+					&& (record.checksum == calibration_checksum(&record))) {
+				context->timing = record.timing;
+				result = 1;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+static inline uint16_t 
+calibration_margin(
+	__in uint16_t value
+	)
+{
+	return (value + (value / CALIBRATION_MARGIN) + CALIBRATION_MARGIN_MIN);
+}
+
+static inline void 
+calibration_store(
+	__in hdcont_t *context,
+	__in uint8_t valid
+	)
+{
+	uint8_t iter, slot = CALIBRATION_SLOT_MAX;
+	uint16_t key;
+	hdcalib_t record;
+
+	if(context) {
+		key = calibration_key(context);
+
+		for(iter = 0; iter < CALIBRATION_SLOT_MAX; ++iter) {
+			eeprom_read_block(&record, &CALIBRATION_RECORD[iter], sizeof(hdcalib_t));
+
+			if((record.magic == CALIBRATION_MAGIC) && (record.key == key)) {
+				slot = iter;
+				break;
+			} else if((slot == CALIBRATION_SLOT_MAX) && ((record.magic != CALIBRATION_MAGIC) 
+					|| (record.checksum != calibration_checksum(&record)))) {
+				slot = iter;
+			}
+		}
+
+		if((slot == CALIBRATION_SLOT_MAX) && valid) {
+			slot = (key % CALIBRATION_SLOT_MAX);
+		}
+
+		if(slot < CALIBRATION_SLOT_MAX) {
+			record.key = key;
+			record.magic = (valid ? CALIBRATION_MAGIC : 0);
+			record.profile = context->profile;
+			record.timing = context->timing;
+			record.checksum = calibration_checksum(&record);
+			eeprom_update_block(&record, &CALIBRATION_RECORD[slot], sizeof(hdcalib_t));
+		}
+	}
+}
+
+uint8_t 
+hd44780_calibrate(
+	__in hdcont_t *context
+	)
+{
+	uint8_t latch, result = 0;
+	uint16_t clear, command, data;
+	hdcont_timing_t timing;
+
+	if(context && !context->schedule) {
+		timing = PROFILE_TIMING(context->profile);
+		context->timing = timing;
+
+		for(latch = (timing.latch - 1); latch; --latch) {
+
+			if(!calibration_latch(context, latch)) {
+				break;
+			}
+
+			context->timing.latch = latch;
+		}
+
+		command = calibration_margin(context->timing.latch);
+		latch = ((command > timing.latch) ? timing.latch : command);
+
+		if(!calibration_latch(context, latch)) {
+			latch = timing.latch;
+		}
+
+		context->timing.latch = latch;
+		command = calibration_execute(context, SELECT_COMMAND, 
+				COMMAND_ENTRY_MODE | FLAG_SHIFT_RIGHT);
+		data = calibration_execute(context, SELECT_DATA, CELL_EMPTY);
+		clear = calibration_execute(context, SELECT_COMMAND, COMMAND_DISPLAY_CLEAR);
+
+		if(clear && (clear < CALIBRATION_TIMEOUT)) {
+
+			if(data > command) {
+				command = data;
+			}
+
+			command = calibration_margin(command);
+			context->timing.command = ((command > UINT8_MAX) ? UINT8_MAX : command);
+			context->timing.timeout = calibration_margin(clear);
+			calibration_store(context, 1);
+			result = 1;
+		} else {
+			context->timing = timing;
+		}
+
+		hd44780_display_clear(context);
+		hd44780_cursor_home(context);
+	}
+
+	return result;
+}
+
+void 
+hd44780_calibration_clear(
+	__in hdcont_t *context
+	)
+{
+	if(context) {
+		context->timing = PROFILE_TIMING(context->profile);
+		calibration_store(context, 0);
+	}
+}
+
+void 
+_hd44780_initialize(
 	__out hdcont_t *context,
+	__in hdmap_t *map,
 	__in uint8_t dimension,
 	__in uint8_t interface,
 	__in uint8_t font,
+	__in uint8_t profile,
 	__in volatile uint8_t *ddr_data,
+	__in volatile uint8_t *pin_data,
 	__in volatile uint8_t *port_data,
 	__in volatile uint8_t *ddr_control,
 	__in volatile uint8_t *port_control,
@@ -374,9 +2059,12 @@ _hd44780_initialize(
 	__in uint8_t pin_control_enable
 	)
 {
-	if(context && ddr_control && ddr_data && port_control && port_data) {
+	if(context && ddr_control && port_control 
+			&& (map || (ddr_data && pin_data && port_data))) {
 		context->dimension = dimension;
 		context->interface = interface;
+		context->profile = (profile > PROFILE_TYPE_MAX ? PROFILE_HD44780 : profile);
+		context->timing = PROFILE_TIMING(context->profile);
 		context->state.current_column = 0;
 		context->state.current_row = 0;
 		context->state.cursor_blink = CURSOR_BLINK_OFF;
@@ -384,51 +2072,89 @@ _hd44780_initialize(
 		context->state.dimension_column = DIMENSION_COLUMN_LENGTH(dimension);
 		context->state.dimension_row = DIMENSION_ROW_LENGTH(dimension);
 		context->state.display_show = DISPLAY_OFF;
+		context->schedule = NULL;
+		context->console = NULL;
+		context->map = map;
+		map_build(context->map, context->interface);
 		context->comm.ddr_control = ddr_control;
 		context->comm.ddr_data = ddr_data;
+		context->comm.pin_data = pin_data;
 		context->comm.port_control = port_control;
 		context->comm.port_data = port_data;
 		context->comm.pin_control_direction = pin_control_direction;
 		context->comm.pin_control_enable = pin_control_enable;
 		context->comm.pin_control_select = pin_control_select;	
+		calibration_load(context);
 		*context->comm.ddr_control |= (_BV(context->comm.pin_control_direction) 
 				| _BV(context->comm.pin_control_enable) 
 				| _BV(context->comm.pin_control_select)); 
 		*context->comm.port_control &= ~(_BV(context->comm.pin_control_direction) 
 				| _BV(context->comm.pin_control_enable) 
 				| _BV(context->comm.pin_control_select));
-		_delay_ms(DELAY_INITIALIZE);
+		timing_delay_ms(context->timing.initialize);
 
-		if(context->interface) {
-			*context->comm.ddr_data = DDR_OUTPUT_8;
-			*context->comm.port_data = 0;
-			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-					COMMAND_FUNCTION_SET | FLAG_INTERFACE | font);
-			hd44780_cursor(context, CURSOR_OFF, CURSOR_BLINK_OFF);
-			hd44780_display(context, DISPLAY_OFF);
-			hd44780_display_clear(context);
-			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-					COMMAND_ENTRY_MODE | FLAG_SHIFT_RIGHT);
-			hd44780_cursor_home(context);
-			hd44780_display(context, DISPLAY_ON);
-			hd44780_cursor(context, CURSOR_ON, CURSOR_BLINK_ON);
-		} else {
-			*context->comm.ddr_data |= DDR_OUTPUT_4;
-			*context->comm.port_data &= ~DDR_OUTPUT_4;
-			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-					COMMAND_FUNCTION_SET | FLAG_INTERFACE | font);
-			hd44780_command_4_nibble(context, COMMAND_CURSOR_HOME);
-			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-					COMMAND_FUNCTION_SET | font);
-			hd44780_cursor(context, CURSOR_OFF, CURSOR_BLINK_OFF);
-			hd44780_display(context, DISPLAY_OFF);
-			hd44780_display_clear(context);
-			hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
-					COMMAND_ENTRY_MODE | FLAG_SHIFT_RIGHT);
-			hd44780_cursor_home(context);
-			hd44780_display(context, DISPLAY_ON);
-			hd44780_cursor(context, CURSOR_ON, CURSOR_BLINK_ON);
+		data_output(context, 0);
+
+		switch(context->profile) {
+			case PROFILE_KS0066:
+
+				if(!context->interface) {
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_SET >> 4);
+				}
+
+				hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+						COMMAND_FUNCTION_SET | (context->interface ? FLAG_INTERFACE : 0) 
+						| font);
+				hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+						COMMAND_FUNCTION_SET | (context->interface ? FLAG_INTERFACE : 0) 
+						| font);
+				break;
+			case PROFILE_WS0010:
+
+				if(!context->interface) {
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_SET >> 4);
+					timing_delay_us(DELAY_RESET_SHORT);
+				}
+
+				hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+						COMMAND_FUNCTION_SET | (context->interface ? FLAG_INTERFACE : 0) 
+						| font);
+				break;
+			default:
+
+				if(context->interface) {
+					hd44780_command_8_byte(context, COMMAND_FUNCTION_RESET << 4);
+					timing_delay_ms(DELAY_RESET_LONG);
+					hd44780_command_8_byte(context, COMMAND_FUNCTION_RESET << 4);
+					timing_delay_us(DELAY_RESET_SHORT);
+					hd44780_command_8_byte(context, COMMAND_FUNCTION_RESET << 4);
+					timing_delay_us(DELAY_RESET_SHORT);
+				} else {
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_RESET);
+					timing_delay_ms(DELAY_RESET_LONG);
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_RESET);
+					timing_delay_us(DELAY_RESET_SHORT);
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_RESET);
+					timing_delay_us(DELAY_RESET_SHORT);
+					hd44780_command_4_nibble(context, COMMAND_FUNCTION_SET >> 4);
+					timing_delay_us(DELAY_RESET_SHORT);
+				}
+
+				hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+						COMMAND_FUNCTION_SET | (context->interface ? FLAG_INTERFACE : 0) 
+						| font);
+				break;
 		}
+
+		hd44780_cursor(context, CURSOR_OFF, CURSOR_BLINK_OFF);
+		hd44780_display(context, DISPLAY_OFF);
+		hd44780_display_clear(context);
+		hd44780_command(context, SELECT_COMMAND, FLAG_DIRECTION_OUTPUT, 
+				COMMAND_ENTRY_MODE | FLAG_SHIFT_RIGHT);
+		hd44780_cursor_home(context);
+		hd44780_oled(context, OLED_MODE_CHARACTER, OLED_POWER_ON);
+		hd44780_display(context, DISPLAY_ON);
+		hd44780_cursor(context, CURSOR_ON, CURSOR_BLINK_ON);
 	}
 }
 
@@ -438,25 +2164,21 @@ hd44780_uninitialize(
 	)
 {
 	if(context) {
+		context->console = NULL;
+		context->schedule = NULL;
 		hd44780_display_clear(context);
 		hd44780_cursor_home(context);
 		hd44780_cursor(context, CURSOR_OFF, CURSOR_BLINK_OFF);
 		hd44780_display(context, DISPLAY_OFF);
+		hd44780_oled(context, OLED_MODE_CHARACTER, OLED_POWER_OFF);
 		*context->comm.port_control &= ~(_BV(context->comm.pin_control_direction) 
 				| _BV(context->comm.pin_control_enable) 
 				| _BV(context->comm.pin_control_select));
 		*context->comm.ddr_control &= ~(_BV(context->comm.pin_control_direction) 
 				| _BV(context->comm.pin_control_enable) 
 				| _BV(context->comm.pin_control_select));
-
-		if(context->interface) {
-			*context->comm.port_data = 0;
-			*context->comm.ddr_data &= ~DDR_OUTPUT_8;
-		} else {
-			*context->comm.port_data &= ~DDR_OUTPUT_4;
-			*context->comm.ddr_data &= ~DDR_OUTPUT_4;
-		}
-
+		data_input(context);
+		context->map = NULL;
 		context->state.current_column = 0;
 		context->state.current_row = 0;
 		context->state.cursor_blink = CURSOR_BLINK_OFF;
@@ -466,5 +2188,6 @@ hd44780_uninitialize(
 		context->state.display_show = DISPLAY_OFF;
 		context->interface = 0;
 		context->dimension = 0;
+		context->profile = PROFILE_HD44780;
 	}
 }